@@ -1,6 +1,7 @@
 #include <stdio.h>    // Per funzioni standard di I/O (printf, scanf, fprintf)
 #include <stdlib.h>   // Per funzioni di utilità generale (es. exit)
 #include <string.h>   // Per manipolazione di stringhe (memset, strcmp)
+#include <time.h>     // Per inizializzare il generatore casuale (time, clock)
 #include <ctype.h>    // Per manipolazione di caratteri (non strettamente usato qui ma utile in generale)
 
 // Disabilita l'avviso di deprecazione per le funzioni Winsock non sicure (come gethostbyname)
@@ -11,18 +12,26 @@
 #include <winsock2.h>   // Contiene definizioni per le funzioni Winsock
 #include <ws2tcpip.h>   // Contiene definizioni aggiuntive per le API di rete
 #pragma comment(lib, "ws2_32.lib") // Collega la libreria ws2_32.lib
+#include <process.h>    // Per _getpid (seme del generatore casuale)
+#define getpid _getpid  // Alias per uniformare la lettura del PID
 #else
 // Blocco per sistemi Unix-like (Linux, macOS, ecc.)
-#include <unistd.h>     // Per funzioni POSIX (es. close)
+#include <unistd.h>     // Per funzioni POSIX (es. close, getpid)
 #include <sys/socket.h> // Definizioni per le API dei socket
 #include <arpa/inet.h>  // Definizioni per le operazioni Internet (es. htons)
 #include <netdb.h>      // Definizioni per la risoluzione dei nomi (es. gethostbyname)
+#include <sys/time.h>   // Definizione di struct timeval (timeout dei socket)
+#include <sys/select.h> // Per select (attesa della connessione con timeout)
+#include <fcntl.h>      // Per fcntl (socket non bloccante)
+#include <errno.h>      // Per errno (EINPROGRESS)
 #define closesocket close // Alias per uniformare la chiusura del socket
 #endif
 
 #define BUFFERSIZE 512              // Dimensione del buffer per la comunicazione
 #define PROTOPORT 5193              // Porta TCP predefinita del server
 #define DEFAULT_SERVER_NAME "localhost" // Nome del server predefinito (non usato nell'input)
+#define MAX_SERVERS 16              // Numero massimo di server nel pool
+#define TIMEOUT_MS 2000             // Attesa massima predefinita di un server (ms), modificabile da linea di comando
 
 // Funzione per la gestione degli errori e la stampa di un messaggio
 void ErrorHandler (const char *errorMessage){
@@ -43,14 +52,115 @@ void ClearWinSock (){
 #endif
 }
 
+// Risolve una lista di nomi di server separati da virgola (es. "host1,host2")
+// e raccoglie in `servers` tutti gli indirizzi IP restituiti da gethostbyname,
+// non solo il primo. Restituisce il numero di indirizzi trovati.
+int RisolviServer (char *lista, int port, struct sockaddr_in *servers, int max_servers){
+    int n = 0;
+    int scartati = 0; // Indirizzi esclusi perché il pool è pieno
+    char *nome = strtok(lista, ",");
+    while (nome != NULL) {
+        struct hostent *host = gethostbyname(nome);
+        if (host == NULL) {
+            fprintf(stderr, "Risoluzione di '%s' fallita, server ignorato.\n", nome);
+        } else {
+            for (int i = 0; host->h_addr_list[i] != NULL; i++) {
+                struct in_addr addr;
+                memcpy(&addr, host->h_addr_list[i], sizeof(addr));
+                // Scarta gli indirizzi duplicati (es. stesso host indicato due volte)
+                int duplicato = 0;
+                for (int j = 0; j < n; j++) {
+                    if (servers[j].sin_addr.s_addr == addr.s_addr) { duplicato = 1; break; }
+                }
+                if (duplicato) continue;
+                if (n >= max_servers) { scartati++; continue; }
+                memset(&servers[n], 0, sizeof(servers[n]));
+                servers[n].sin_family = AF_INET;
+                servers[n].sin_addr = addr;
+                servers[n].sin_port = htons(port);
+                n++;
+            }
+        }
+        nome = strtok(NULL, ",");
+    }
+    if (scartati > 0) {
+        fprintf(stderr, "Pool pieno (%d server): %d indirizzi ignorati.\n", max_servers, scartati);
+    }
+    return n;
+}
+
+// Imposta un timeout (in millisecondi) sulla ricezione del socket, così un server
+// lento o non raggiungibile non blocca il client. Con ms = 0 l'attesa torna illimitata.
+void ImpostaTimeout (int sock, int ms){
+#if defined WIN32 || defined _WIN32
+    DWORD timeout = ms;
+#else
+    struct timeval timeout;
+    timeout.tv_sec = ms / 1000;
+    timeout.tv_usec = (ms % 1000) * 1000;
+#endif
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
+}
+
+// Connette il socket al server attendendo al massimo `ms` millisecondi.
+// Usa una connect non bloccante seguita da select, perché Winsock ignora
+// SO_SNDTIMEO su connect: un host che non risponde verrebbe atteso ~21s.
+// Restituisce 0 se la connessione è riuscita, -1 altrimenti.
+int ConnettiConTimeout (int sock, struct sockaddr_in *sad, int ms){
+#if defined WIN32 || defined _WIN32
+    u_long non_bloccante = 1;
+    ioctlsocket(sock, FIONBIO, &non_bloccante);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+
+    int esito = connect(sock, (struct sockaddr *)sad, sizeof(*sad));
+    if (esito < 0) {
+#if defined WIN32 || defined _WIN32
+        int in_corso = (WSAGetLastError() == WSAEWOULDBLOCK);
+#else
+        int in_corso = (errno == EINPROGRESS);
+#endif
+        if (in_corso) {
+            fd_set scrittura, errori;
+            FD_ZERO(&scrittura); FD_SET(sock, &scrittura);
+            // Su Windows una connessione fallita è segnalata nell'insieme degli errori
+            FD_ZERO(&errori); FD_SET(sock, &errori);
+            struct timeval timeout;
+            timeout.tv_sec = ms / 1000;
+            timeout.tv_usec = (ms % 1000) * 1000;
+            if (select(sock + 1, NULL, &scrittura, &errori, &timeout) > 0 && FD_ISSET(sock, &scrittura)) {
+                // Il socket è scrivibile anche se la connessione è fallita: controlla SO_ERROR
+                int errore = 0;
+                socklen_t errore_len = sizeof(errore); // socklen_t è definito anche da ws2tcpip.h
+                getsockopt(sock, SOL_SOCKET, SO_ERROR, (char*)&errore, &errore_len);
+                if (errore == 0) esito = 0;
+            }
+        }
+    }
+
+    // Ripristina la modalità bloccante usata dal resto del client
+#if defined WIN32 || defined _WIN32
+    non_bloccante = 0;
+    ioctlsocket(sock, FIONBIO, &non_bloccante);
+#else
+    fcntl(sock, F_SETFL, flags);
+#endif
+    return esito;
+}
+
 // Funzione principale del client
 int main(int argc, char *argv[]){
     char server_input[BUFFERSIZE];  // Buffer per leggere il nome del server
     char *server_name;              // Puntatore al nome del server
     int port = PROTOPORT;           // Porta del server (usa il valore predefinito)
+    int timeout_ms = TIMEOUT_MS;    // Attesa massima di un server prima di provare il successivo
+    // Se fornito un argomento da linea di comando, usalo come attesa massima (ms)
+    if (argc > 1 && atoi(argv[1]) > 0) timeout_ms = atoi(argv[1]);
 
-    // 2. Richiesta nome server all'utente
-    printf("Inserisci il nome del server (es. 'localhost'): ");
+    // 2. Richiesta nome server all'utente (uno o più server separati da virgola)
+    printf("Inserisci il nome del server (es. 'localhost' o 'host1,host2'): ");
     if (scanf("%s", server_input) != 1) {
         printf("Input non valido.\n"); return -1;
     }
@@ -62,57 +172,94 @@ int main(int argc, char *argv[]){
     if (WSAStartup(MAKEWORD(2,2), &wsaData) != 0) { ErrorHandler("WSAStartup fallito."); return -1; }
 #endif
     
-    // 3. Risoluzione del nome e preparazione della connessione
-    struct hostent *host;
-    // gethostbyname risolve il nome del server (es. "localhost" o "www.example.com") nel suo indirizzo IP.
-    if ((host = gethostbyname(server_name)) == NULL) { 
+    // 3. Risoluzione dei nomi: il pool contiene tutti gli indirizzi risolti di tutti i server indicati
+    struct sockaddr_in servers[MAX_SERVERS];
+    int num_servers = RisolviServer(server_name, port, servers, MAX_SERVERS);
+    if (num_servers == 0) { 
         ErrorHandler("Risoluzione nome host fallita."); 
         ClearWinSock(); 
         return -1; 
     }
 
-    struct sockaddr_in sad; // Struttura per l'indirizzo del socket (server address)
-    memset(&sad, 0, sizeof(sad)); // Inizializza la struttura a zero
-    sad.sin_family = AF_INET; // Specifica la famiglia di indirizzi (Internet)
-    // Copia il primo indirizzo IP risolto nella struttura sad.
-    sad.sin_addr.s_addr = *(u_long*)host->h_addr_list[0]; 
-    // Imposta la porta, convertendo in Network Byte Order (Big-Endian)
-    sad.sin_port = htons(port); 
-
-    // Creazione del socket client
-    int clientSocket;
-    // socket(famiglia, tipo, protocollo): crea un socket TCP (PF_INET, SOCK_STREAM, IPPROTO_TCP)
-    if ((clientSocket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) { 
-        ErrorHandler("Creazione socket client fallita."); 
-        ClearWinSock(); 
-        return -1; 
-    }
+    // Il server di partenza è scelto a caso: più client distribuiscono così il carico sull'intero pool.
+    // Il seme combina ora, PID e clock, così client avviati nello stesso secondo non scelgono tutti lo stesso server.
+    srand((unsigned)time(NULL) ^ ((unsigned)getpid() << 16) ^ (unsigned)clock());
+    int primo = rand() % num_servers;
 
-    // PUNTO DELL'ERRORE: La chiamata 'connect'
-    // Tenta di stabilire una connessione TCP con il server specificato in sad.
-    if (connect(clientSocket, (struct sockaddr *)&sad, sizeof(sad)) < 0) { 
-        ErrorHandler("Connessione fallita. Controlla che il server sia attivo."); 
-        closesocket(clientSocket); 
-        ClearWinSock(); 
-        return -1;
-    }
-    printf("Connessione al server %s sulla porta %d riuscita.\n", server_name, port);
-    
+    int clientSocket = -1;   // Socket connesso al server scelto
+    int socketInAttesa = -1; // Primo server che ha accettato la connessione ma non ha ancora inviato il benvenuto
+    struct sockaddr_in sadInAttesa;
     char buffer[BUFFERSIZE]; // Buffer per la ricezione e l'invio di dati
     int bytes_received;      // Numero di byte ricevuti
 
-    // 5. Ricezione e stampa del messaggio iniziale di benvenuto dal server
-    // recv riceve dati dal socket (bloccante)
-    bytes_received = recv(clientSocket, buffer, BUFFERSIZE - 1, 0);
-    if (bytes_received > 0) {
-        buffer[bytes_received] = '\0'; // Terminatore di stringa
-        printf("Server: %s\n", buffer);
+    // 4. Prova i server del pool a partire da quello scelto.
+    // Un server che rifiuta la connessione o non la accetta entro timeout_ms viene escluso.
+    // Un server che accetta ma non invia il benvenuto entro timeout_ms è solo occupato con un altro
+    // client (il server TCP ne serve uno alla volta): si passa al successivo, ma il primo di questi
+    // resta collegato come riserva.
+    for (int i = 0; i < num_servers && clientSocket < 0; i++) {
+        struct sockaddr_in sad = servers[(primo + i) % num_servers];
+
+        // socket(famiglia, tipo, protocollo): crea un socket TCP (PF_INET, SOCK_STREAM, IPPROTO_TCP)
+        int sock;
+        if ((sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) { 
+            ErrorHandler("Creazione socket client fallita."); 
+            if (socketInAttesa >= 0) closesocket(socketInAttesa);
+            ClearWinSock(); 
+            return -1; 
+        }
+        ImpostaTimeout(sock, timeout_ms);
+
+        // Tenta di stabilire una connessione TCP con il server specificato in sad.
+        if (ConnettiConTimeout(sock, &sad, timeout_ms) < 0) { 
+            fprintf(stderr, "Server %s non raggiungibile, escluso.\n", inet_ntoa(sad.sin_addr)); 
+            closesocket(sock); 
+            continue;
+        }
+
+        // 5. Ricezione e stampa del messaggio iniziale di benvenuto dal server
+        bytes_received = recv(sock, buffer, BUFFERSIZE - 1, 0);
+        if (bytes_received == 0) {
+            fprintf(stderr, "Server %s ha chiuso la connessione, escluso.\n", inet_ntoa(sad.sin_addr)); 
+            closesocket(sock); 
+            continue;
+        }
+        if (bytes_received < 0) {
+            fprintf(stderr, "Server %s occupato, si prova il successivo.\n", inet_ntoa(sad.sin_addr)); 
+            if (socketInAttesa < 0) { socketInAttesa = sock; sadInAttesa = sad; }
+            else closesocket(sock);
+            continue;
+        }
+        clientSocket = sock;
+        printf("Connessione al server %s sulla porta %d riuscita.\n", inet_ntoa(sad.sin_addr), port);
+    }
+
+    if (clientSocket >= 0) {
+        // Trovato un server libero: la riserva non serve più
+        if (socketInAttesa >= 0) closesocket(socketInAttesa);
+    } else if (socketInAttesa >= 0) {
+        // Tutti i server raggiungibili sono occupati: come il client originale,
+        // si attende senza limite il benvenuto del primo che ha accettato la connessione
+        printf("Tutti i server sono occupati, attesa del server %s...\n", inet_ntoa(sadInAttesa.sin_addr));
+        ImpostaTimeout(socketInAttesa, 0);
+        bytes_received = recv(socketInAttesa, buffer, BUFFERSIZE - 1, 0);
+        if (bytes_received <= 0) {
+            ErrorHandler("Ricezione conferma connessione fallita (o server disconnesso)."); 
+            closesocket(socketInAttesa); 
+            ClearWinSock(); 
+            return -1;
+        }
+        clientSocket = socketInAttesa;
+        printf("Connessione al server %s sulla porta %d riuscita.\n", inet_ntoa(sadInAttesa.sin_addr), port);
     } else {
-        ErrorHandler("Ricezione conferma connessione fallita (o server disconnesso)."); 
-        closesocket(clientSocket); 
+        ErrorHandler("Connessione fallita. Controlla che almeno un server sia attivo."); 
         ClearWinSock(); 
         return -1;
     }
+    buffer[bytes_received] = '\0'; // Terminatore di stringa
+    printf("Server: %s\n", buffer);
+    // Server scelto: da qui in poi l'attesa delle risposte torna illimitata come prima
+    ImpostaTimeout(clientSocket, 0);
 
     // 6. Lettura e invio del comando (carattere singolo)
     char command;
@@ -1,6 +1,7 @@
 #include <stdio.h>    // Per funzioni standard di I/O
 #include <stdlib.h>   // Per funzioni di utilità generale
 #include <string.h>   // Per manipolazione di stringhe (es. memset)
+#include <time.h>     // Per inizializzare il generatore casuale (time, clock)
 #include <ctype.h>    // Per manipolazione di caratteri
 
 // Disabilita l'avviso di deprecazione per le funzioni Winsock non sicure (come gethostbyname)
@@ -11,18 +12,23 @@
 #include <winsock2.h>   // Contiene definizioni per le funzioni Winsock
 #include <ws2tcpip.h>   // Contiene definizioni aggiuntive per le API di rete
 #pragma comment(lib, "ws2_32.lib") // Collega la libreria ws2_32.lib
+#include <process.h>    // Per _getpid (seme del generatore casuale)
+#define getpid _getpid  // Alias per uniformare la lettura del PID
 #else
 // Blocco per sistemi Unix-like (Linux, macOS, ecc.)
-#include <unistd.h>     // Per funzioni POSIX (es. close)
+#include <unistd.h>     // Per funzioni POSIX (es. close, getpid)
 #include <sys/socket.h> // Definizioni per le API dei socket
 #include <arpa/inet.h>  // Definizioni per le operazioni Internet (es. htons)
 #include <netdb.h>      // Definizioni per la risoluzione dei nomi (es. gethostbyname)
+#include <sys/time.h>   // Definizione di struct timeval (timeout dei socket)
 #define closesocket close // Alias per uniformare la chiusura del socket
 #endif
 
 #define BUFFERSIZE 512              // Dimensione del buffer per la comunicazione
 #define PROTOPORT 5193              // Porta UDP predefinita del server
 #define DEFAULT_SERVER_NAME "localhost" // Nome del server predefinito
+#define MAX_SERVERS 16              // Numero massimo di server nel pool
+#define TIMEOUT_MS 2000             // Attesa massima predefinita di un server (ms), modificabile da linea di comando
 
 // Funzione per la gestione degli errori e la stampa di un messaggio
 void ErrorHandler (const char *errorMessage){
@@ -41,13 +47,110 @@ void ClearWinSock (){
 #endif
 }
 
+// Risolve una lista di nomi di server separati da virgola (es. "host1,host2")
+// e raccoglie in `servers` tutti gli indirizzi IP restituiti da gethostbyname,
+// non solo il primo. Restituisce il numero di indirizzi trovati.
+int RisolviServer (char *lista, int port, struct sockaddr_in *servers, int max_servers){
+    int n = 0;
+    int scartati = 0; // Indirizzi esclusi perché il pool è pieno
+    char *nome = strtok(lista, ",");
+    while (nome != NULL) {
+        struct hostent *host = gethostbyname(nome);
+        if (host == NULL) {
+            fprintf(stderr, "Risoluzione di '%s' fallita, server ignorato.\n", nome);
+        } else {
+            for (int i = 0; host->h_addr_list[i] != NULL; i++) {
+                struct in_addr addr;
+                memcpy(&addr, host->h_addr_list[i], sizeof(addr));
+                // Scarta gli indirizzi duplicati (es. stesso host indicato due volte)
+                int duplicato = 0;
+                for (int j = 0; j < n; j++) {
+                    if (servers[j].sin_addr.s_addr == addr.s_addr) { duplicato = 1; break; }
+                }
+                if (duplicato) continue;
+                if (n >= max_servers) { scartati++; continue; }
+                memset(&servers[n], 0, sizeof(servers[n]));
+                servers[n].sin_family = AF_INET;
+                servers[n].sin_addr = addr;
+                servers[n].sin_port = htons(port);
+                n++;
+            }
+        }
+        nome = strtok(NULL, ",");
+    }
+    if (scartati > 0) {
+        fprintf(stderr, "Pool pieno (%d server): %d indirizzi ignorati.\n", max_servers, scartati);
+    }
+    return n;
+}
+
+// Imposta un timeout (in millisecondi) sulla ricezione del socket, così un server
+// lento o non raggiungibile non blocca il client. Con ms = 0 l'attesa torna illimitata.
+void ImpostaTimeout (int sock, int ms){
+#if defined WIN32 || defined _WIN32
+    DWORD timeout = ms;
+#else
+    struct timeval timeout;
+    timeout.tv_sec = ms / 1000;
+    timeout.tv_usec = (ms % 1000) * 1000;
+#endif
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
+}
+
+// Restituisce un istante in millisecondi, usato per calcolare le scadenze delle attese.
+long OraMs (){
+#if defined WIN32 || defined _WIN32
+    return (long)GetTickCount();
+#else
+    struct timeval ora;
+    gettimeofday(&ora, NULL);
+    return ora.tv_sec * 1000L + ora.tv_usec / 1000;
+#endif
+}
+
+// Riceve un datagramma proveniente solo da `server` (stesso indirizzo e stessa porta).
+// Le risposte in ritardo di server già esclusi vengono scartate, così non possono
+// essere scambiate per la risposta del server scelto.
+// Con ms > 0 l'attesa complessiva non supera ms millisecondi, anche se arrivano datagrammi
+// da scartare; con ms = 0 l'attesa è illimitata.
+// Restituisce i byte ricevuti, oppure un valore negativo in caso di errore o timeout.
+int RiceviDaServer (int sock, char *buffer, int len, struct sockaddr_in *server, int ms){
+    struct sockaddr_in mittente; // Indirizzo di chi ha inviato il datagramma
+    socklen_t mittente_len;      // socklen_t è definito anche da ws2tcpip.h
+    long scadenza = OraMs() + ms;
+    while (1) {
+        if (ms > 0) {
+            long restante = scadenza - OraMs();
+            if (restante <= 0) return -1;
+            ImpostaTimeout(sock, (int)restante);
+        } else {
+            ImpostaTimeout(sock, 0);
+        }
+        mittente_len = sizeof(mittente);
+        int bytes = recvfrom(sock, buffer, len, 0, (struct sockaddr *)&mittente, &mittente_len);
+#if defined WIN32 || defined _WIN32
+        // Su Windows un ICMP "porta non raggiungibile" per un invio precedente
+        // fa fallire la recvfrom successiva: non riguarda il server atteso
+        if (bytes < 0 && WSAGetLastError() == WSAECONNRESET) continue;
+#endif
+        if (bytes < 0) return bytes;
+        if (mittente.sin_addr.s_addr == server->sin_addr.s_addr && mittente.sin_port == server->sin_port) {
+            return bytes;
+        }
+        fprintf(stderr, "Scartato datagramma inatteso da %s.\n", inet_ntoa(mittente.sin_addr));
+    }
+}
+
 int main(int argc, char *argv[]){
     char server_input[BUFFERSIZE];  // Buffer per leggere il nome del server
     char *server_name;              // Puntatore al nome del server
     int port = PROTOPORT;           // Porta del server
+    int timeout_ms = TIMEOUT_MS;    // Attesa massima di un server prima di provare il successivo
+    // Se fornito un argomento da linea di comando, usalo come attesa massima (ms)
+    if (argc > 1 && atoi(argv[1]) > 0) timeout_ms = atoi(argv[1]);
 
-    // Richiesta nome server all'utente
-    printf("Inserisci il nome del server (es. 'localhost'): "); 
+    // Richiesta nome server all'utente (uno o più server separati da virgola)
+    printf("Inserisci il nome del server (es. 'localhost' o 'host1,host2'): "); 
     if (scanf("%s", server_input) != 1) { printf("Input non valido.\n"); return -1; }
     server_name = server_input; // Imposta il nome del server letto
 
@@ -57,21 +160,20 @@ int main(int argc, char *argv[]){
     if (WSAStartup(MAKEWORD(2,2), &wsaData) != 0) { ErrorHandler("WSAStartup fallito."); return -1; }
 #endif
     
-    // Risoluzione del nome DNS
-    struct hostent *host;
-    // gethostbyname risolve il nome del server nel suo indirizzo IP.
-    if ((host = gethostbyname(server_name)) == NULL) { 
+    // Risoluzione dei nomi DNS: il pool contiene tutti gli indirizzi risolti di tutti i server indicati
+    struct sockaddr_in servers[MAX_SERVERS];
+    int num_servers = RisolviServer(server_name, port, servers, MAX_SERVERS);
+    if (num_servers == 0) { 
         ErrorHandler("Risoluzione nome host fallita."); ClearWinSock(); return -1; 
     }
 
-    // Setup indirizzo server (sad = Server Address)
+    // Il server di partenza è scelto a caso: più client distribuiscono così il carico sull'intero pool.
+    // Il seme combina ora, PID e clock, così client avviati nello stesso secondo non scelgono tutti lo stesso server.
+    srand((unsigned)time(NULL) ^ ((unsigned)getpid() << 16) ^ (unsigned)clock());
+    int primo = rand() % num_servers;
+
+    // Indirizzo del server scelto (sad = Server Address)
     struct sockaddr_in sad;
-    memset(&sad, 0, sizeof(sad)); // Inizializza la struttura a zero
-    sad.sin_family = AF_INET; // Famiglia di indirizzi (Internet)
-    // Copia il primo indirizzo IP risolto
-    sad.sin_addr.s_addr = *(u_long*)host->h_addr_list[0];
-    // Imposta la porta, convertendo in Network Byte Order
-    sad.sin_port = htons(port);
     int sad_len = sizeof(sad); // Lunghezza della struttura dell'indirizzo
 
     // Creazione Socket UDP
@@ -80,32 +182,53 @@ int main(int argc, char *argv[]){
     if ((clientSocket = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP)) < 0) { 
         ErrorHandler("Creazione socket client fallita."); ClearWinSock(); return -1; 
     }
-    
 
-    printf("Client UDP pronto per la comunicazione con %s:%d.\n", server_name, port);
+    printf("Client UDP pronto per la comunicazione con un pool di %d server sulla porta %d.\n", num_servers, port);
 
-    // 1. Lettura e invio comando (carattere singolo)
+    // 1. Lettura comando (carattere singolo)
     char command;
     printf("Inserisci l'operazione (A/S/M/D o altro per terminare): ");
     // L'uso di " %c" ignora gli spazi bianchi lasciati da input precedenti
     if (scanf(" %c", &command) != 1) { command = 'X'; } 
 
-    // Invio del comando (sendto)
-    // Invia 1 byte di dati (il comando) all'indirizzo specificato in `sad`.
-    if (sendto(clientSocket, &command, 1, 0, (struct sockaddr *)&sad, sad_len) != 1) { 
-        ErrorHandler("Invio comando fallito."); closesocket(clientSocket); ClearWinSock(); return -1;
-    }
-
-    // 2. Ricezione stringa operazione/terminazione
+    // 2. Invio comando e ricezione stringa operazione/terminazione
     char buffer[BUFFERSIZE];
-    int bytes_received;
-    
-    // Ricezione della risposta dal server (recvfrom)
-    // Riceve un datagramma e memorizza l'indirizzo del mittente in `sad` (anche se qui è già preimpostato, è la pratica standard per UDP).
-    bytes_received = recvfrom(clientSocket, buffer, BUFFERSIZE - 1, 0, (struct sockaddr *)&sad, &sad_len);
+    int bytes_received = -1;
+
+    // Il server UDP, dopo aver risposto ad A/S/M/D, resta in attesa degli operandi da chiunque
+    char cmd = toupper(command);
+    int operazione = (cmd == 'A' || cmd == 'S' || cmd == 'M' || cmd == 'D');
+
+    // Prova i server del pool a partire da quello scelto: un server che non risponde
+    // entro timeout_ms viene escluso e il comando viene inviato al successivo
+    for (int i = 0; i < num_servers && bytes_received <= 0; i++) {
+        sad = servers[(primo + i) % num_servers];
+        sad_len = sizeof(sad);
+
+        // Invio del comando (sendto)
+        // Invia 1 byte di dati (il comando) all'indirizzo specificato in `sad`.
+        if (sendto(clientSocket, &command, 1, 0, (struct sockaddr *)&sad, sad_len) != 1) { 
+            fprintf(stderr, "Invio comando a %s fallito, server escluso.\n", inet_ntoa(sad.sin_addr));
+            continue;
+        }
+
+        // Ricezione della risposta dal server (recvfrom)
+        // Sono accettati solo datagrammi provenienti da `sad`, il server a cui è stato inviato il comando.
+        bytes_received = RiceviDaServer(clientSocket, buffer, BUFFERSIZE - 1, &sad, timeout_ms);
+        if (bytes_received <= 0) {
+            fprintf(stderr, "Server %s non ha risposto in tempo, escluso.\n", inet_ntoa(sad.sin_addr));
+            // Se il server è solo lento, prima o poi leggerà il comando e aspetterà gli operandi:
+            // gli si inviano due operandi nulli, così torna in attesa di comandi invece di
+            // consumare come operandi il comando del prossimo client. La sua risposta viene scartata.
+            if (operazione) {
+                int rilascio[2] = { 0, 0 };
+                sendto(clientSocket, (char*)rilascio, sizeof(rilascio), 0, (struct sockaddr *)&sad, sad_len);
+            }
+        }
+    }
     if (bytes_received <= 0) { ErrorHandler("Ricezione stringa operazione fallita."); closesocket(clientSocket); ClearWinSock(); return -1; }
     buffer[bytes_received] = '\0';
-    printf("Server risponde: %s\n", buffer);
+    printf("Server %s risponde: %s\n", inet_ntoa(sad.sin_addr), buffer);
 
     // 3. Se l'operazione è aritmetica, chiede e invia i due interi
     if (strcmp(buffer, "ADDIZIONE") == 0 || strcmp(buffer, "SOTTRAZIONE") == 0 || 
@@ -126,8 +249,11 @@ int main(int argc, char *argv[]){
                 
                 // 4. Ricezione e stampa del risultato
                 int risultato_net;
-                // Riceve il risultato (4 byte) dal server (recvfrom)
-                if (recvfrom(clientSocket, (char*)&risultato_net, sizeof(risultato_net), 0, (struct sockaddr *)&sad, &sad_len) == sizeof(risultato_net)) {
+                // Riceve il risultato (4 byte) dal server scelto, senza limite di attesa come prima.
+                // Il buffer è più grande del risultato, così un datagramma di lunghezza diversa
+                // non viene troncato e scambiato per un intero.
+                if (RiceviDaServer(clientSocket, buffer, BUFFERSIZE, &sad, 0) == sizeof(risultato_net)) {
+                    memcpy(&risultato_net, buffer, sizeof(risultato_net));
                     // Conversione del risultato da Network Byte Order a Host Byte Order
                     int risultato = ntohl(risultato_net); 
                     printf("\nRISULTATO RICEVUTO: %d\n", risultato);